@@ -1,4 +1,5 @@
 #include <cstdint>
+#include <span>
 #include <string>
 #include <memory>
 
@@ -6,6 +7,13 @@
 
 Bus::Bus(const std::string& prog_path) : dram_{std::make_unique<DRAM>(prog_path)} {}
 
+Bus::Bus(std::span<const uint8_t> image) : dram_{std::make_unique<DRAM>(image)} {}
+
+void Bus::Reset(std::span<const uint8_t> image) {
+  dram_->Clear();
+  dram_->LoadProgram(image);
+}
+
 uint64_t Bus::Load(uint64_t addr, int size) {
   return dram_->Load(addr, size);
 }
@@ -13,3 +21,11 @@ uint64_t Bus::Load(uint64_t addr, int size) {
 void Bus::Store(uint64_t addr, int size, uint64_t data) {
   dram_->Store(addr, size, data);
 }
+
+void Bus::Read(uint64_t addr, std::span<uint8_t> dst) const {
+  dram_->Read(addr, dst);
+}
+
+void Bus::Write(uint64_t addr, std::span<const uint8_t> src) {
+  dram_->Write(addr, src);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <string>
 #include <memory>
 
@@ -9,8 +10,12 @@
 class Bus {
  public:
   Bus(const std::string& prog_path);
+  Bus(std::span<const uint8_t> image);
+  void Reset(std::span<const uint8_t> image);
   uint64_t Load(uint64_t addr, int size);
   void Store(uint64_t addr, int size, uint64_t data);
+  void Read(uint64_t addr, std::span<uint8_t> dst) const;
+  void Write(uint64_t addr, std::span<const uint8_t> src);
 
  private:
   std::unique_ptr<DRAM> dram_;
@@ -0,0 +1,40 @@
+#include <stdint.h>
+
+#include "riscvemu.h"
+
+/* Built as C so that riscvemu.h is checked to be valid C. Returns 0 on success. */
+int RunCApiTest(void) {
+  static const uint8_t kAddi[] = {0x13, 0x05, 0xa0, 0x02}; /* addi a0, zero, 42 */
+  static const uint8_t kIllegal[] = {0xff, 0xff, 0xff, 0xff};
+  uint64_t instr_count = 0;
+  int failed = 0;
+
+  rvemu_pool* pool = rvemu_pool_create(1);
+  if (pool == NULL)
+    return 1;
+
+  rvemu_machine* machine = rvemu_pool_acquire(pool, kAddi, sizeof(kAddi));
+  if (machine == NULL) {
+    rvemu_pool_destroy(pool);
+    return 1;
+  }
+  if (rvemu_machine_run(machine, 100, &instr_count) != RVEMU_HALTED || instr_count != 1)
+    failed = 1;
+  if (rvemu_machine_read_reg(machine, 10) != 42) /* a0 */
+    failed = 1;
+  if (rvemu_machine_run(machine, 100, &instr_count) != RVEMU_HALTED || instr_count != 0)
+    failed = 1;
+  rvemu_pool_release(pool, machine);
+
+  machine = rvemu_machine_create(kIllegal, sizeof(kIllegal));
+  if (machine == NULL) {
+    rvemu_pool_destroy(pool);
+    return 1;
+  }
+  if (rvemu_machine_run(machine, 100, NULL) != RVEMU_FAULT || rvemu_machine_fault_message(machine)[0] == '\0')
+    failed = 1;
+  rvemu_machine_destroy(machine);
+
+  rvemu_pool_destroy(pool);
+  return failed;
+}
@@ -5,14 +5,66 @@
 #include <fstream>
 #include <filesystem>
 #include <bitset>
+#include <bit>
+#include <algorithm>
 
 #include "cpu.hpp"
+#include "error.hpp"
+
+// Without -mpopcnt/-mlzcnt the compiler falls back to a libgcc call or a bsr
+// sequence, so use the host instruction when the CPU reports the feature.
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HOST_X86_BITOPS 1
+#endif
+
+#ifdef HOST_X86_BITOPS
+// target_clones with an ISA name dispatches on __builtin_cpu_supports("popcnt").
+__attribute__((target_clones("popcnt", "default")))
+#endif
+static uint64_t Popcount(uint64_t x) {
+  return static_cast<uint64_t>(__builtin_popcountll(x));
+}
+
+#ifdef HOST_X86_BITOPS
+// lzcnt cannot be a target_clones option, so dispatch by hand.
+__attribute__((target("lzcnt")))
+static uint64_t CountLeadingZerosLzcnt(uint64_t x) {
+  return (x == 0) ? 64 : static_cast<uint64_t>(__builtin_clzll(x));
+}
+#endif
+
+static uint64_t CountLeadingZeros(uint64_t x) {
+#ifdef HOST_X86_BITOPS
+  static const bool kHasLzcnt = __builtin_cpu_supports("lzcnt");
+  if (kHasLzcnt)
+    return CountLeadingZerosLzcnt(x);
+#endif
+  return (x == 0) ? 64 : static_cast<uint64_t>(__builtin_clzll(x));
+}
+
+// bsf/tzcnt is available on every x86-64 host.
+static uint64_t CountTrailingZeros(uint64_t x) {
+  return (x == 0) ? 64 : static_cast<uint64_t>(__builtin_ctzll(x));
+}
 
 CPU::CPU(const std::string& prog_path)
     : regs_{}, pc_{kDramBaseAddr}, bus_{std::make_unique<Bus>(prog_path)} {
   regs_[2] = kDramBaseAddr + kDramSize - 1; // sp
 }
 
+CPU::CPU(std::span<const uint8_t> image)
+    : regs_{}, pc_{kDramBaseAddr}, bus_{std::make_unique<Bus>(image)} {
+  regs_[2] = kDramBaseAddr + kDramSize - 1; // sp
+}
+
+void CPU::Reset(std::span<const uint8_t> image) {
+  // Reset the registers first so that a failed load still leaves a clean CPU.
+  regs_ = {};
+  regs_[2] = kDramBaseAddr + kDramSize - 1; // sp
+  pc_ = kDramBaseAddr;
+  bus_->Reset(image);
+}
+
 uint32_t CPU::Fetch() {
   return static_cast<uint32_t>(bus_->Load(pc_, 32));
 }
@@ -47,8 +99,7 @@ uint64_t CPU::Execute(uint32_t instr) {
       regs_[decoded.i_type.rd] = bus_->Load(static_cast<int64_t>(regs_[decoded.i_type.rs1]) + SignExtend<int64_t>(decoded.i_type.imm_11_0, 12), 32);
       break;
     default:
-      std::cerr << "Unknown funct3: 0b" << std::bitset<3>(decoded.i_type.funct3) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-      std::exit(EXIT_FAILURE);
+      ThrowError("Unknown funct3: 0b", std::bitset<3>(decoded.i_type.funct3), " in opcode: 0b", std::bitset<7>(opcode));
     }
     break;
   case 0b0010011: {
@@ -57,9 +108,48 @@ uint64_t CPU::Execute(uint32_t instr) {
     case 0b000: // addi
       regs_[decoded.i_type.rd] = static_cast<int64_t>(regs_[decoded.i_type.rs1]) + SignExtend<int64_t>(decoded.i_type.imm_11_0, 12);
       break;
-    case 0b001: // slli, RV64I
-      regs_[decoded.i_type.rd] = static_cast<uint64_t>(regs_[decoded.i_type.rs1] << shamt);
+    case 0b001: {
+      uint8_t imm_11_6 = decoded.i_type.imm_11_0 >> 6;
+      switch (imm_11_6) {
+      case 0b000000: // slli, RV64I
+        regs_[decoded.i_type.rd] = static_cast<uint64_t>(regs_[decoded.i_type.rs1] << shamt);
+        break;
+      case 0b001010: // bseti, Zbs
+        regs_[decoded.i_type.rd] = regs_[decoded.i_type.rs1] | (1ull << shamt);
+        break;
+      case 0b010010: // bclri, Zbs
+        regs_[decoded.i_type.rd] = regs_[decoded.i_type.rs1] & ~(1ull << shamt);
+        break;
+      case 0b011010: // binvi, Zbs
+        regs_[decoded.i_type.rd] = regs_[decoded.i_type.rs1] ^ (1ull << shamt);
+        break;
+      case 0b011000:
+        // The rs2 field selects the unary operation.
+        switch (shamt) {
+        case 0b000000: // clz, Zbb
+          regs_[decoded.i_type.rd] = CountLeadingZeros(regs_[decoded.i_type.rs1]);
+          break;
+        case 0b000001: // ctz, Zbb
+          regs_[decoded.i_type.rd] = CountTrailingZeros(regs_[decoded.i_type.rs1]);
+          break;
+        case 0b000010: // cpop, Zbb
+          regs_[decoded.i_type.rd] = Popcount(regs_[decoded.i_type.rs1]);
+          break;
+        case 0b000100: // sext.b, Zbb
+          regs_[decoded.i_type.rd] = static_cast<uint64_t>(static_cast<int8_t>(regs_[decoded.i_type.rs1]));
+          break;
+        case 0b000101: // sext.h, Zbb
+          regs_[decoded.i_type.rd] = static_cast<uint64_t>(static_cast<int16_t>(regs_[decoded.i_type.rs1]));
+          break;
+        default:
+          ThrowError("Unknown imm_5_0: 0b", std::bitset<6>(shamt), " in opcode: 0b", std::bitset<7>(opcode));
+        }
+        break;
+      default:
+        ThrowError("Unknown imm_11_6: 0b", std::bitset<6>(imm_11_6), " in opcode: 0b", std::bitset<7>(opcode));
+      }
       break;
+    }
     case 0b010: // slti
       regs_[decoded.i_type.rd] = static_cast<uint64_t>((static_cast<int64_t>(regs_[decoded.i_type.rs1]) < SignExtend<int64_t>(decoded.i_type.imm_11_0, 12)) ? 1u : 0u);
       break;
@@ -78,9 +168,30 @@ uint64_t CPU::Execute(uint32_t instr) {
       case 0b010000: // srai, RV64I
         regs_[decoded.i_type.rd] = static_cast<uint64_t>(static_cast<int64_t>(regs_[decoded.i_type.rs1]) >> shamt);
         break;
+      case 0b010010: // bexti, Zbs
+        regs_[decoded.i_type.rd] = (regs_[decoded.i_type.rs1] >> shamt) & 1;
+        break;
+      case 0b011000: // rori, Zbb
+        regs_[decoded.i_type.rd] = std::rotr(regs_[decoded.i_type.rs1], static_cast<int>(shamt));
+        break;
+      case 0b001010: { // orc.b, Zbb
+        if (shamt != 0b000111) {
+          ThrowError("Unknown imm_5_0: 0b", std::bitset<6>(shamt), " in opcode: 0b", std::bitset<7>(opcode));
+        }
+        // Set the MSB of each byte that has any bit set, then widen it to the whole byte.
+        uint64_t x = regs_[decoded.i_type.rs1];
+        uint64_t msbs = (((x & 0x7F7F'7F7F'7F7F'7F7Full) + 0x7F7F'7F7F'7F7F'7F7Full) | x) & 0x8080'8080'8080'8080ull;
+        regs_[decoded.i_type.rd] = (msbs >> 7) * 0xFF;
+        break;
+      }
+      case 0b011010: // rev8, Zbb
+        if (shamt != 0b111000) {
+          ThrowError("Unknown imm_5_0: 0b", std::bitset<6>(shamt), " in opcode: 0b", std::bitset<7>(opcode));
+        }
+        regs_[decoded.i_type.rd] = std::byteswap(regs_[decoded.i_type.rs1]);
+        break;
       default:
-        std::cerr << "Unknown imm_11_6: 0b" << std::bitset<6>(imm_11_6) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-        std::exit(EXIT_FAILURE);
+        ThrowError("Unknown imm_11_6: 0b", std::bitset<6>(imm_11_6), " in opcode: 0b", std::bitset<7>(opcode));
       }
       break;
     }
@@ -106,9 +217,37 @@ uint64_t CPU::Execute(uint32_t instr) {
     case 0b000: // addiw, RV64I
       regs_[decoded.i_type.rd] = static_cast<int32_t>(static_cast<int64_t>(regs_[decoded.i_type.rs1]) + SignExtend<int64_t>(decoded.i_type.imm_11_0, 12));
       break;
-    case 0b001: // slliw, RV64I
-      regs_[decoded.i_type.rd] = static_cast<int32_t>(regs_[decoded.i_type.rs1] << shamt);
+    case 0b001: {
+      uint8_t imm_11_5 = decoded.i_type.imm_11_0 >> 5;
+      switch (imm_11_5) {
+      case 0b0000000: // slliw, RV64I
+        regs_[decoded.i_type.rd] = static_cast<int32_t>(regs_[decoded.i_type.rs1] << shamt);
+        break;
+      case 0b0000100:
+      case 0b0000101: // slli.uw, Zba (takes a 6-bit shamt)
+        regs_[decoded.i_type.rd] = static_cast<uint64_t>(static_cast<uint32_t>(regs_[decoded.i_type.rs1])) << (decoded.i_type.imm_11_0 & 0x3F);
+        break;
+      case 0b0110000:
+        // The rs2 field selects the unary operation.
+        switch (shamt) {
+        case 0b00000: // clzw, Zbb
+          regs_[decoded.i_type.rd] = CountLeadingZeros(static_cast<uint32_t>(regs_[decoded.i_type.rs1])) - 32;
+          break;
+        case 0b00001: // ctzw, Zbb
+          regs_[decoded.i_type.rd] = std::min<uint64_t>(CountTrailingZeros(static_cast<uint32_t>(regs_[decoded.i_type.rs1])), 32);
+          break;
+        case 0b00010: // cpopw, Zbb
+          regs_[decoded.i_type.rd] = Popcount(static_cast<uint32_t>(regs_[decoded.i_type.rs1]));
+          break;
+        default:
+          ThrowError("Unknown imm_4_0: 0b", std::bitset<5>(shamt), " in opcode: 0b", std::bitset<7>(opcode));
+        }
+        break;
+      default:
+        ThrowError("Unknown imm_11_5: 0b", std::bitset<7>(imm_11_5), " in opcode: 0b", std::bitset<7>(opcode));
+      }
       break;
+    }
     case 0b101: {
       uint8_t imm_11_5 = decoded.i_type.imm_11_0 >> 5;
       switch (imm_11_5) {
@@ -118,15 +257,16 @@ uint64_t CPU::Execute(uint32_t instr) {
       case 0b0100000: // sraiw, RV64I
         regs_[decoded.i_type.rd] = static_cast<int32_t>(static_cast<int64_t>(regs_[decoded.i_type.rs1]) >> shamt);
         break;
+      case 0b0110000: // roriw, Zbb
+        regs_[decoded.i_type.rd] = static_cast<int32_t>(std::rotr(static_cast<uint32_t>(regs_[decoded.i_type.rs1]), static_cast<int>(shamt)));
+        break;
       default:
-        std::cerr << "Unknown imm_11_5: 0b" << std::bitset<7>(imm_11_5) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-        std::exit(EXIT_FAILURE);
+        ThrowError("Unknown imm_11_5: 0b", std::bitset<7>(imm_11_5), " in opcode: 0b", std::bitset<7>(opcode));
       }
       break;
     }
     default:
-      std::cerr << "Unknown funct3: 0b" << std::bitset<3>(decoded.i_type.funct3) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-      std::exit(EXIT_FAILURE);
+      ThrowError("Unknown funct3: 0b", std::bitset<3>(decoded.i_type.funct3), " in opcode: 0b", std::bitset<7>(opcode));
     }
     break;
   }
@@ -146,8 +286,7 @@ uint64_t CPU::Execute(uint32_t instr) {
       bus_->Store(static_cast<int64_t>(regs_[decoded.s_type.rs1]) + imm, 64, regs_[decoded.s_type.rs2]);
       break;
     default:
-      std::cerr << "Unknown funct3: 0b" << std::bitset<3>(decoded.s_type.funct3) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-      std::exit(EXIT_FAILURE);
+      ThrowError("Unknown funct3: 0b", std::bitset<3>(decoded.s_type.funct3), " in opcode: 0b", std::bitset<7>(opcode));
     }
     break;
   }
@@ -162,21 +301,68 @@ uint64_t CPU::Execute(uint32_t instr) {
         regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] - regs_[decoded.r_type.rs2];
         break;
       default:
-        std::cerr << "Unknown funct7: 0b" << std::bitset<7>(decoded.r_type.funct7) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-        std::exit(EXIT_FAILURE);
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
       }
       break;
-    case 0b001: // sll
-      regs_[decoded.r_type.rd] = static_cast<uint64_t>(regs_[decoded.r_type.rs1] << regs_[decoded.r_type.rs2]);
+    case 0b001:
+      switch (decoded.r_type.funct7) {
+      case 0b0000000: // sll
+        regs_[decoded.r_type.rd] = static_cast<uint64_t>(regs_[decoded.r_type.rs1] << regs_[decoded.r_type.rs2]);
+        break;
+      case 0b0110000: // rol, Zbb
+        regs_[decoded.r_type.rd] = std::rotl(regs_[decoded.r_type.rs1], static_cast<int>(regs_[decoded.r_type.rs2] & 0x3F));
+        break;
+      case 0b0010100: // bset, Zbs
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] | (1ull << (regs_[decoded.r_type.rs2] & 0x3F));
+        break;
+      case 0b0100100: // bclr, Zbs
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] & ~(1ull << (regs_[decoded.r_type.rs2] & 0x3F));
+        break;
+      case 0b0110100: // binv, Zbs
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] ^ (1ull << (regs_[decoded.r_type.rs2] & 0x3F));
+        break;
+      default:
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
+      }
       break;
-    case 0b010: // slt
-      regs_[decoded.r_type.rd] = static_cast<uint64_t>((static_cast<int64_t>(regs_[decoded.r_type.rs1]) < static_cast<int64_t>(regs_[decoded.r_type.rs2])) ? 1u : 0u);
+    case 0b010:
+      switch (decoded.r_type.funct7) {
+      case 0b0000000: // slt
+        regs_[decoded.r_type.rd] = static_cast<uint64_t>((static_cast<int64_t>(regs_[decoded.r_type.rs1]) < static_cast<int64_t>(regs_[decoded.r_type.rs2])) ? 1u : 0u);
+        break;
+      case 0b0010000: // sh1add, Zba
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs2] + (regs_[decoded.r_type.rs1] << 1);
+        break;
+      default:
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
+      }
       break;
-    case 0b011: // sltu
-      regs_[decoded.r_type.rd] = static_cast<uint64_t>((regs_[decoded.r_type.rs1] < regs_[decoded.r_type.rs2]) ? 1u : 0u);
+    case 0b011:
+      switch (decoded.r_type.funct7) {
+      case 0b0000000: // sltu
+        regs_[decoded.r_type.rd] = static_cast<uint64_t>((regs_[decoded.r_type.rs1] < regs_[decoded.r_type.rs2]) ? 1u : 0u);
+        break;
+      default:
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
+      }
       break;
-    case 0b100: // xor
-      regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] ^ regs_[decoded.r_type.rs2];
+    case 0b100:
+      switch (decoded.r_type.funct7) {
+      case 0b0000000: // xor
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] ^ regs_[decoded.r_type.rs2];
+        break;
+      case 0b0100000: // xnor, Zbb
+        regs_[decoded.r_type.rd] = ~(regs_[decoded.r_type.rs1] ^ regs_[decoded.r_type.rs2]);
+        break;
+      case 0b0010000: // sh2add, Zba
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs2] + (regs_[decoded.r_type.rs1] << 2);
+        break;
+      case 0b0000101: // min, Zbb
+        regs_[decoded.r_type.rd] = static_cast<uint64_t>(std::min(static_cast<int64_t>(regs_[decoded.r_type.rs1]), static_cast<int64_t>(regs_[decoded.r_type.rs2])));
+        break;
+      default:
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
+      }
       break;
     case 0b101:
       switch (decoded.r_type.funct7) {
@@ -186,16 +372,51 @@ uint64_t CPU::Execute(uint32_t instr) {
       case 0b0100000: // sra
         regs_[decoded.r_type.rd] = static_cast<uint64_t>(static_cast<int64_t>(regs_[decoded.r_type.rs1]) >> regs_[decoded.r_type.rs2]);
         break;
+      case 0b0110000: // ror, Zbb
+        regs_[decoded.r_type.rd] = std::rotr(regs_[decoded.r_type.rs1], static_cast<int>(regs_[decoded.r_type.rs2] & 0x3F));
+        break;
+      case 0b0100100: // bext, Zbs
+        regs_[decoded.r_type.rd] = (regs_[decoded.r_type.rs1] >> (regs_[decoded.r_type.rs2] & 0x3F)) & 1;
+        break;
+      case 0b0000101: // minu, Zbb
+        regs_[decoded.r_type.rd] = std::min(regs_[decoded.r_type.rs1], regs_[decoded.r_type.rs2]);
+        break;
       default:
-        std::cerr << "Unknown funct7: 0b" << std::bitset<7>(decoded.r_type.funct7) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-        std::exit(EXIT_FAILURE);
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
       }
       break;
-    case 0b110: // or
-      regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] | regs_[decoded.r_type.rs2];
+    case 0b110:
+      switch (decoded.r_type.funct7) {
+      case 0b0000000: // or
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] | regs_[decoded.r_type.rs2];
+        break;
+      case 0b0100000: // orn, Zbb
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] | ~regs_[decoded.r_type.rs2];
+        break;
+      case 0b0010000: // sh3add, Zba
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs2] + (regs_[decoded.r_type.rs1] << 3);
+        break;
+      case 0b0000101: // max, Zbb
+        regs_[decoded.r_type.rd] = static_cast<uint64_t>(std::max(static_cast<int64_t>(regs_[decoded.r_type.rs1]), static_cast<int64_t>(regs_[decoded.r_type.rs2])));
+        break;
+      default:
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
+      }
       break;
-    case 0b111: // and
-      regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] & regs_[decoded.r_type.rs2];
+    case 0b111:
+      switch (decoded.r_type.funct7) {
+      case 0b0000000: // and
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] & regs_[decoded.r_type.rs2];
+        break;
+      case 0b0100000: // andn, Zbb
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs1] & ~regs_[decoded.r_type.rs2];
+        break;
+      case 0b0000101: // maxu, Zbb
+        regs_[decoded.r_type.rd] = std::max(regs_[decoded.r_type.rs1], regs_[decoded.r_type.rs2]);
+        break;
+      default:
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
+      }
       break;
     default:
       assert(false);
@@ -214,13 +435,49 @@ uint64_t CPU::Execute(uint32_t instr) {
       case 0b0100000: // subw, RV64I
         regs_[decoded.r_type.rd] = static_cast<int32_t>(static_cast<int64_t>(regs_[decoded.r_type.rs1]) - static_cast<int64_t>(regs_[decoded.r_type.rs2]));
         break;
+      case 0b0000100: // add.uw, Zba
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs2] + static_cast<uint64_t>(static_cast<uint32_t>(regs_[decoded.r_type.rs1]));
+        break;
+      default:
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
+      }
+      break;
+    case 0b001:
+      switch (decoded.r_type.funct7) {
+      case 0b0000000: // sllw, RV64I
+        regs_[decoded.r_type.rd] = static_cast<int32_t>(regs_[decoded.r_type.rs1] << (regs_[decoded.r_type.rs2] & 0x1F));
+        break;
+      case 0b0110000: // rolw, Zbb
+        regs_[decoded.r_type.rd] = static_cast<int32_t>(std::rotl(static_cast<uint32_t>(regs_[decoded.r_type.rs1]), static_cast<int>(regs_[decoded.r_type.rs2] & 0x1F)));
+        break;
       default:
-        std::cerr << "Unknown funct7: 0b" << std::bitset<7>(decoded.r_type.funct7) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-        std::exit(EXIT_FAILURE);
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
       }
       break;
-    case 0b001: // sllw, RV64I
-      regs_[decoded.r_type.rd] = static_cast<int32_t>(regs_[decoded.r_type.rs1] << (regs_[decoded.r_type.rs2] & 0x1F));
+    case 0b010:
+      switch (decoded.r_type.funct7) {
+      case 0b0010000: // sh1add.uw, Zba
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs2] + (static_cast<uint64_t>(static_cast<uint32_t>(regs_[decoded.r_type.rs1])) << 1);
+        break;
+      default:
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
+      }
+      break;
+    case 0b100:
+      switch (decoded.r_type.funct7) {
+      case 0b0010000: // sh2add.uw, Zba
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs2] + (static_cast<uint64_t>(static_cast<uint32_t>(regs_[decoded.r_type.rs1])) << 2);
+        break;
+      case 0b0000100: // zext.h, Zbb
+        // With rs2 != x0 this encoding is packw, which is not implemented.
+        if (decoded.r_type.rs2 != 0) {
+          ThrowError("Unknown rs2: 0b", std::bitset<5>(decoded.r_type.rs2), " in opcode: 0b", std::bitset<7>(opcode));
+        }
+        regs_[decoded.r_type.rd] = static_cast<uint16_t>(regs_[decoded.r_type.rs1]);
+        break;
+      default:
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
+      }
       break;
     case 0b101:
       switch (decoded.r_type.funct7) {
@@ -230,14 +487,24 @@ uint64_t CPU::Execute(uint32_t instr) {
       case 0b0100000: // sraw, RV64I
         regs_[decoded.r_type.rd] = static_cast<int32_t>(static_cast<int32_t>(regs_[decoded.r_type.rs1]) >> (regs_[decoded.r_type.rs2] & 0x1F));
         break;
+      case 0b0110000: // rorw, Zbb
+        regs_[decoded.r_type.rd] = static_cast<int32_t>(std::rotr(static_cast<uint32_t>(regs_[decoded.r_type.rs1]), static_cast<int>(regs_[decoded.r_type.rs2] & 0x1F)));
+        break;
+      default:
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
+      }
+      break;
+    case 0b110:
+      switch (decoded.r_type.funct7) {
+      case 0b0010000: // sh3add.uw, Zba
+        regs_[decoded.r_type.rd] = regs_[decoded.r_type.rs2] + (static_cast<uint64_t>(static_cast<uint32_t>(regs_[decoded.r_type.rs1])) << 3);
+        break;
       default:
-        std::cerr << "Unknown funct7: 0b" << std::bitset<7>(decoded.r_type.funct7) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-        std::exit(EXIT_FAILURE);
+        ThrowError("Unknown funct7: 0b", std::bitset<7>(decoded.r_type.funct7), " in opcode: 0b", std::bitset<7>(opcode));
       }
       break;
     default:
-      std::cerr << "Unknown funct3: 0b" << std::bitset<3>(decoded.r_type.funct3) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-      std::exit(EXIT_FAILURE);
+      ThrowError("Unknown funct3: 0b", std::bitset<3>(decoded.r_type.funct3), " in opcode: 0b", std::bitset<7>(opcode));
     }
     break;
   case 0b1100011: {
@@ -274,8 +541,7 @@ uint64_t CPU::Execute(uint32_t instr) {
       }
       break;
     default:
-      std::cerr << "Unknown funct3: 0b" << std::bitset<3>(decoded.b_type.funct3) << " in opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-      std::exit(EXIT_FAILURE);
+      ThrowError("Unknown funct3: 0b", std::bitset<3>(decoded.b_type.funct3), " in opcode: 0b", std::bitset<7>(opcode));
     }
     break;
   }
@@ -296,17 +562,41 @@ uint64_t CPU::Execute(uint32_t instr) {
     return static_cast<uint64_t>(static_cast<int64_t>(pc_) + imm);
   }
   default:
-    std::cerr << "Unknown opcode: 0b" << std::bitset<7>(opcode) << std::endl;
-    std::exit(EXIT_FAILURE);
+    ThrowError("Unknown opcode: 0b", std::bitset<7>(opcode));
   }
 
   return pc_ + 4;
 }
 
+uint64_t CPU::GetPC() const {
+  return pc_;
+}
+
 void CPU::SetPC(uint64_t pc) {
   pc_ = pc;
 }
 
+uint64_t CPU::GetReg(int index) const {
+  if (index < 0 || index >= static_cast<int>(regs_.size())) {
+    ThrowError("Invalid register index: ", index);
+  }
+  return regs_[index];
+}
+
+void CPU::SetReg(int index, uint64_t val) {
+  if (index < 0 || index >= static_cast<int>(regs_.size())) {
+    ThrowError("Invalid register index: ", index);
+  }
+  // x0 is hardwired to zero.
+  if (index != 0) {
+    regs_[index] = val;
+  }
+}
+
+Bus& CPU::GetBus() {
+  return *bus_;
+}
+
 void CPU::PrintRegs() const {
   int i = 0;
   for (auto reg : regs_) {
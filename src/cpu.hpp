@@ -2,11 +2,13 @@
 
 #include <iostream>
 #include <array>
+#include <span>
 #include <string>
 #include <vector>
 #include <memory>
 
 #include "bus.hpp"
+#include "error.hpp"
 
 union DecodedType {
   uint32_t raw;
@@ -80,9 +82,15 @@ enum RegisterABI {
 class CPU {
  public:
   CPU(const std::string& prog_path);
+  CPU(std::span<const uint8_t> image);
+  void Reset(std::span<const uint8_t> image);
   uint32_t Fetch();
   uint64_t Execute(uint32_t instr);
+  uint64_t GetPC() const;
   void SetPC(uint64_t pc);
+  uint64_t GetReg(int index) const;
+  void SetReg(int index, uint64_t val);
+  Bus& GetBus();
   void PrintRegs() const;
   template <class... Args> void AssertRegEq(Args... args) const;
 
@@ -98,8 +106,7 @@ class CPU {
 template <class T>
 T CPU::SignExtend(T val, int bits) const {
   if (static_cast<size_t>(bits) > sizeof(T) * 8) {
-    std::cerr << "bits: " << bits << " is larger than sizeof(T): " << sizeof(T) << std::endl;
-    std::exit(EXIT_FAILURE);
+    ThrowError("bits: ", bits, " is larger than sizeof(T): ", sizeof(T));
   }
   T msb_set = 1 << (bits - 1);
   return (val ^ msb_set) - msb_set;
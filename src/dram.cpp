@@ -1,40 +1,91 @@
+#include <sys/mman.h>
+#include <cerrno>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
-#include <iostream>
+#include <iterator>
 #include <string>
+#include <vector>
 
 #include "dram.hpp"
+#include "error.hpp"
 
-DRAM::DRAM(const std::string& prog_path) : dram_{} {
+DRAM::DRAM() : dram_{nullptr} {
+  void* mem = mmap(nullptr, kDramSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mem == MAP_FAILED) {
+    ThrowError("Failed to allocate DRAM: ", std::strerror(errno));
+  }
+  dram_ = static_cast<uint8_t*>(mem);
+}
+
+DRAM::DRAM(const std::string& prog_path) : DRAM() {
   LoadProgram(prog_path);
 }
 
+DRAM::DRAM(std::span<const uint8_t> image) : DRAM() {
+  LoadProgram(image);
+}
+
+DRAM::~DRAM() {
+  munmap(dram_, kDramSize);
+}
+
 void DRAM::LoadProgram(const std::string& path) {
   namespace fs = std::filesystem;
   if (!fs::is_regular_file(path)) {
-    std::cerr << fs::weakly_canonical(fs::absolute(path)) << " is not a regular file" << std::endl;
-    std::exit(EXIT_FAILURE);
+    ThrowError(fs::weakly_canonical(fs::absolute(path)), " is not a regular file");
   }
   std::ifstream ifs{path, std::ios::in | std::ios::binary};
   if (!ifs.is_open()) {
-    std::cerr << "Failed to open " << fs::weakly_canonical(fs::absolute(path)) << std::endl;
-    std::exit(EXIT_FAILURE);
+    ThrowError("Failed to open ", fs::weakly_canonical(fs::absolute(path)));
+  }
+
+  std::vector<uint8_t> image{std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+  LoadProgram(image);
+}
+
+void DRAM::LoadProgram(std::span<const uint8_t> image) {
+  if (image.size() > kDramSize) {
+    ThrowError("Program is too large: ", image.size(), " bytes");
   }
+  if (!image.empty()) {
+    std::memcpy(dram_, image.data(), image.size());
+  }
+}
+
+void DRAM::Clear() {
+  // Drop the pages instead of zeroing them; they read back as zero.
+  if (madvise(dram_, kDramSize, MADV_DONTNEED) != 0) {
+    std::memset(dram_, 0, kDramSize);
+  }
+}
+
+void DRAM::Read(uint64_t addr, std::span<uint8_t> dst) const {
+  CheckRange(addr, dst.size());
+  if (!dst.empty()) {
+    std::memcpy(dst.data(), dram_ + (addr - kDramBaseAddr), dst.size());
+  }
+}
+
+void DRAM::Write(uint64_t addr, std::span<const uint8_t> src) {
+  CheckRange(addr, src.size());
+  if (!src.empty()) {
+    std::memcpy(dram_ + (addr - kDramBaseAddr), src.data(), src.size());
+  }
+}
 
-  char data;
-  for (int i = 0; ifs.get(data); ++i) {
-    dram_[i] = static_cast<uint8_t>(data);
+void DRAM::CheckRange(uint64_t addr, uint64_t len) const {
+  if ((addr < kDramBaseAddr) || (len > kDramSize) || (addr - kDramBaseAddr > kDramSize - len)) {
+    ThrowError("Invalid access: 0x", std::hex, addr, " (0x", len, " bytes)");
   }
 }
 
 uint64_t DRAM::Load(uint64_t addr, int size) const {
   if (size != 8 && size != 16 && size != 32 && size != 64) {
-    std::cerr << "Invalid load size: " << size << std::endl;
-    std::exit(EXIT_FAILURE);
+    ThrowError("Invalid load size: ", size);
   }
-  if ((addr < kDramBaseAddr) || (kDramBaseAddr + kDramSize <= addr)) {
-    std::cerr << "Invalid load address: 0x" << std::hex << static_cast<int>(addr) << std::endl;
-    std::exit(EXIT_FAILURE);
+  if ((addr < kDramBaseAddr) || (kDramBaseAddr + kDramSize - size / 8 < addr)) {
+    ThrowError("Invalid load address: 0x", std::hex, addr);
   }
 
   uint64_t dram_addr = addr - kDramBaseAddr;
@@ -49,12 +100,10 @@ uint64_t DRAM::Load(uint64_t addr, int size) const {
 
 void DRAM::Store(uint64_t addr, int size, uint64_t data) {
   if (size != 8 && size != 16 && size != 32 && size != 64) {
-    std::cerr << "Invalid store size: " << size << std::endl;
-    std::exit(EXIT_FAILURE);
+    ThrowError("Invalid store size: ", size);
   }
-  if ((addr < kDramBaseAddr) || (kDramBaseAddr + kDramSize <= addr)) {
-    std::cerr << "Invalid store address: 0x" << std::hex << static_cast<int>(addr) << std::endl;
-    std::exit(EXIT_FAILURE);
+  if ((addr < kDramBaseAddr) || (kDramBaseAddr + kDramSize - size / 8 < addr)) {
+    ThrowError("Invalid store address: 0x", std::hex, addr);
   }
 
   uint64_t dram_addr = addr - kDramBaseAddr;
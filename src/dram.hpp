@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cstdint>
-#include <array>
+#include <span>
 #include <string>
 
 constexpr uint64_t kDramSize = static_cast<uint64_t>(1024 * 1024 * 128); // 128 MiB
@@ -9,11 +9,25 @@ constexpr uint64_t kDramBaseAddr = 0x8000'0000; // DRAM starts at 0x8000'0000 in
 
 class DRAM {
  public:
+  DRAM();
   DRAM(const std::string& prog_path);
+  DRAM(std::span<const uint8_t> image);
+  ~DRAM();
+  DRAM(const DRAM&) = delete;
+  DRAM& operator=(const DRAM&) = delete;
+
   void LoadProgram(const std::string& path);
+  void LoadProgram(std::span<const uint8_t> image);
+  void Clear();
+  void Read(uint64_t addr, std::span<uint8_t> dst) const;
+  void Write(uint64_t addr, std::span<const uint8_t> src);
   uint64_t Load(uint64_t addr, int size) const;
   void Store(uint64_t addr, int size, uint64_t data);
 
  private:
-  std::array<uint8_t, kDramSize> dram_;
+  void CheckRange(uint64_t addr, uint64_t len) const;
+
+  // Anonymous mapping: pages are zero-filled by the kernel on first touch, so
+  // creating and clearing a DRAM costs only what the guest actually used.
+  uint8_t* dram_;
 };
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// Symbols that libriscvemu exports; everything else is built hidden.
+#ifndef RISCVEMU_API
+#define RISCVEMU_API __attribute__((visibility("default")))
+#endif
+
+// Raised when the guest does something the emulator cannot continue from
+// (unknown instruction, out-of-range access, ...). The emulator itself never
+// exits the process, so that it can be embedded as a library.
+class RISCVEMU_API EmulatorError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+template <class... Args>
+[[noreturn]] void ThrowError(const Args&... args) {
+  std::ostringstream oss;
+  (oss << ... << args);
+  throw EmulatorError{oss.str()};
+}
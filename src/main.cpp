@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "cpu.hpp"
+#include "error.hpp"
 #include "test.hpp"
 
 int main(int argc, char** argv) {
@@ -26,25 +27,30 @@ int main(int argc, char** argv) {
     }
   }
 
-  if (do_test) {
-    auto test = std::make_unique<Test>();
-    test->Run();
-    return 0;
-  }
+  try {
+    if (do_test) {
+      auto test = std::make_unique<Test>();
+      test->Run();
+      return 0;
+    }
 
-  auto cpu = std::make_unique<CPU>(argv[1]);
+    auto cpu = std::make_unique<CPU>(argv[1]);
+
+    std::cout << "Running..." << std::endl;
+    for(;;) {
+      cpu->PrintRegs();
+      uint32_t instr = cpu->Fetch();
+      if (instr == 0)
+        break;
+      uint64_t new_pc = cpu->Execute(instr);
+      cpu->SetPC(new_pc);
+      if (new_pc == 0)
+        break;
+    }
 
-  std::cout << "Running..." << std::endl;
-  for(;;) {
     cpu->PrintRegs();
-    uint32_t instr = cpu->Fetch();
-    if (instr == 0)
-      break;
-    uint64_t new_pc = cpu->Execute(instr);
-    cpu->SetPC(new_pc);
-    if (new_pc == 0)
-      break;
+  } catch (const EmulatorError& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
   }
-
-  cpu->PrintRegs();
 }
@@ -0,0 +1,247 @@
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "riscvemu.hpp"
+#include "riscvemu.h"
+#include "cpu.hpp"
+#include "error.hpp"
+
+namespace riscvemu {
+
+std::unique_ptr<Machine> Machine::Create(std::span<const uint8_t> image) {
+  return std::unique_ptr<Machine>{new Machine{image}};
+}
+
+Machine::Machine(std::span<const uint8_t> image) : cpu_{std::make_unique<CPU>(image)}, fault_{}, halted_{false} {}
+
+Machine::~Machine() = default;
+
+void Machine::Reset(std::span<const uint8_t> image) {
+  fault_.clear();
+  halted_ = false;
+  cpu_->Reset(image);
+}
+
+RunResult Machine::Run(uint64_t max_instrs) {
+  uint64_t instr_count = 0;
+  if (halted_)
+    return {RunStatus::kHalted, instr_count};
+  try {
+    while (instr_count < max_instrs) {
+      uint32_t instr = cpu_->Fetch();
+      if (instr == 0) {
+        halted_ = true;
+        return {RunStatus::kHalted, instr_count};
+      }
+      uint64_t new_pc = cpu_->Execute(instr);
+      ++instr_count;
+      cpu_->SetPC(new_pc);
+      if (new_pc == 0) {
+        halted_ = true;
+        return {RunStatus::kHalted, instr_count};
+      }
+    }
+  } catch (const EmulatorError& e) {
+    fault_ = e.what();
+    return {RunStatus::kFault, instr_count};
+  }
+  return {RunStatus::kBudgetExhausted, instr_count};
+}
+
+const std::string& Machine::FaultMessage() const {
+  return fault_;
+}
+
+uint64_t Machine::ReadReg(int index) const {
+  return cpu_->GetReg(index);
+}
+
+void Machine::WriteReg(int index, uint64_t val) {
+  cpu_->SetReg(index, val);
+}
+
+uint64_t Machine::ReadPC() const {
+  return cpu_->GetPC();
+}
+
+void Machine::WritePC(uint64_t pc) {
+  cpu_->SetPC(pc);
+  halted_ = false;
+}
+
+bool Machine::ReadMem(uint64_t addr, void* dst, size_t len) {
+  try {
+    cpu_->GetBus().Read(addr, {static_cast<uint8_t*>(dst), len});
+  } catch (const EmulatorError&) {
+    return false;
+  }
+  return true;
+}
+
+bool Machine::WriteMem(uint64_t addr, const void* src, size_t len) {
+  try {
+    cpu_->GetBus().Write(addr, {static_cast<const uint8_t*>(src), len});
+  } catch (const EmulatorError&) {
+    return false;
+  }
+  return true;
+}
+
+MachinePool::MachinePool(size_t initial_size) : mutex_{}, free_{} {
+  for (size_t i = 0; i < initial_size; ++i) {
+    free_.push_back(Machine::Create({}));
+  }
+}
+
+std::unique_ptr<Machine> MachinePool::Acquire(std::span<const uint8_t> image) {
+  std::unique_ptr<Machine> machine;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!free_.empty()) {
+      machine = std::move(free_.back());
+      free_.pop_back();
+    }
+  }
+  if (!machine)
+    return Machine::Create(image);
+
+  machine->Reset(image);
+  return machine;
+}
+
+void MachinePool::Release(std::unique_ptr<Machine> machine) {
+  if (!machine)
+    return;
+  std::lock_guard<std::mutex> lock{mutex_};
+  free_.push_back(std::move(machine));
+}
+
+} // namespace riscvemu
+
+// C API. Handles are the C++ objects themselves; no exception crosses this boundary.
+
+using riscvemu::Machine;
+using riscvemu::MachinePool;
+
+namespace {
+
+Machine* ToMachine(rvemu_machine* machine) {
+  return reinterpret_cast<Machine*>(machine);
+}
+
+const Machine* ToMachine(const rvemu_machine* machine) {
+  return reinterpret_cast<const Machine*>(machine);
+}
+
+rvemu_machine* ToHandle(std::unique_ptr<Machine> machine) {
+  return reinterpret_cast<rvemu_machine*>(machine.release());
+}
+
+MachinePool* ToPool(rvemu_pool* pool) {
+  return reinterpret_cast<MachinePool*>(pool);
+}
+
+} // namespace
+
+extern "C" {
+
+rvemu_machine* rvemu_machine_create(const uint8_t* image, size_t size) {
+  try {
+    return ToHandle(Machine::Create({image, size}));
+  } catch (const std::exception&) {
+    return nullptr;
+  }
+}
+
+void rvemu_machine_destroy(rvemu_machine* machine) {
+  delete ToMachine(machine);
+}
+
+int rvemu_machine_reset(rvemu_machine* machine, const uint8_t* image, size_t size) {
+  try {
+    ToMachine(machine)->Reset({image, size});
+    return 0;
+  } catch (const std::exception&) {
+    return -1;
+  }
+}
+
+rvemu_status rvemu_machine_run(rvemu_machine* machine, uint64_t max_instrs, uint64_t* instr_count) {
+  riscvemu::RunResult result = ToMachine(machine)->Run(max_instrs);
+  if (instr_count != nullptr)
+    *instr_count = result.instr_count;
+  switch (result.status) {
+  case riscvemu::RunStatus::kHalted:
+    return RVEMU_HALTED;
+  case riscvemu::RunStatus::kBudgetExhausted:
+    return RVEMU_BUDGET_EXHAUSTED;
+  default:
+    return RVEMU_FAULT;
+  }
+}
+
+const char* rvemu_machine_fault_message(const rvemu_machine* machine) {
+  return ToMachine(machine)->FaultMessage().c_str();
+}
+
+uint64_t rvemu_machine_read_reg(const rvemu_machine* machine, int index) {
+  if (index < 0 || index >= 32)
+    return 0;
+  return ToMachine(machine)->ReadReg(index);
+}
+
+void rvemu_machine_write_reg(rvemu_machine* machine, int index, uint64_t val) {
+  if (index < 0 || index >= 32)
+    return;
+  ToMachine(machine)->WriteReg(index, val);
+}
+
+uint64_t rvemu_machine_read_pc(const rvemu_machine* machine) {
+  return ToMachine(machine)->ReadPC();
+}
+
+void rvemu_machine_write_pc(rvemu_machine* machine, uint64_t pc) {
+  ToMachine(machine)->WritePC(pc);
+}
+
+int rvemu_machine_read_mem(rvemu_machine* machine, uint64_t addr, void* dst, size_t len) {
+  return ToMachine(machine)->ReadMem(addr, dst, len) ? 0 : -1;
+}
+
+int rvemu_machine_write_mem(rvemu_machine* machine, uint64_t addr, const void* src, size_t len) {
+  return ToMachine(machine)->WriteMem(addr, src, len) ? 0 : -1;
+}
+
+rvemu_pool* rvemu_pool_create(size_t initial_size) {
+  try {
+    return reinterpret_cast<rvemu_pool*>(new MachinePool{initial_size});
+  } catch (const std::exception&) {
+    return nullptr;
+  }
+}
+
+void rvemu_pool_destroy(rvemu_pool* pool) {
+  delete ToPool(pool);
+}
+
+rvemu_machine* rvemu_pool_acquire(rvemu_pool* pool, const uint8_t* image, size_t size) {
+  try {
+    return ToHandle(ToPool(pool)->Acquire({image, size}));
+  } catch (const std::exception&) {
+    return nullptr;
+  }
+}
+
+void rvemu_pool_release(rvemu_pool* pool, rvemu_machine* machine) {
+  try {
+    ToPool(pool)->Release(std::unique_ptr<Machine>{ToMachine(machine)});
+  } catch (const std::exception&) {
+    // The machine has already been destroyed; nothing else to undo.
+  }
+}
+
+} // extern "C"
@@ -0,0 +1,49 @@
+#ifndef RISCVEMU_H_
+#define RISCVEMU_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef RISCVEMU_API
+#define RISCVEMU_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rvemu_machine rvemu_machine;
+typedef struct rvemu_pool rvemu_pool;
+
+typedef enum {
+  RVEMU_HALTED,
+  RVEMU_BUDGET_EXHAUSTED,
+  RVEMU_FAULT,
+} rvemu_status;
+
+/* Functions returning a pointer return NULL on failure; functions returning int return 0 on success. */
+
+RISCVEMU_API rvemu_machine* rvemu_machine_create(const uint8_t* image, size_t size);
+RISCVEMU_API void rvemu_machine_destroy(rvemu_machine* machine);
+RISCVEMU_API int rvemu_machine_reset(rvemu_machine* machine, const uint8_t* image, size_t size);
+RISCVEMU_API rvemu_status rvemu_machine_run(rvemu_machine* machine, uint64_t max_instrs, uint64_t* instr_count);
+/* The returned string is owned by the machine and is only valid until the next run or reset. */
+RISCVEMU_API const char* rvemu_machine_fault_message(const rvemu_machine* machine);
+
+RISCVEMU_API uint64_t rvemu_machine_read_reg(const rvemu_machine* machine, int index);
+RISCVEMU_API void rvemu_machine_write_reg(rvemu_machine* machine, int index, uint64_t val);
+RISCVEMU_API uint64_t rvemu_machine_read_pc(const rvemu_machine* machine);
+RISCVEMU_API void rvemu_machine_write_pc(rvemu_machine* machine, uint64_t pc);
+RISCVEMU_API int rvemu_machine_read_mem(rvemu_machine* machine, uint64_t addr, void* dst, size_t len);
+RISCVEMU_API int rvemu_machine_write_mem(rvemu_machine* machine, uint64_t addr, const void* src, size_t len);
+
+RISCVEMU_API rvemu_pool* rvemu_pool_create(size_t initial_size);
+RISCVEMU_API void rvemu_pool_destroy(rvemu_pool* pool);
+RISCVEMU_API rvemu_machine* rvemu_pool_acquire(rvemu_pool* pool, const uint8_t* image, size_t size);
+RISCVEMU_API void rvemu_pool_release(rvemu_pool* pool, rvemu_machine* machine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RISCVEMU_H_
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "error.hpp"
+
+class CPU;
+
+namespace riscvemu {
+
+enum class RunStatus {
+  kHalted,          // Fetched a zero instruction or jumped to address 0. Stays halted until Reset() or WritePC().
+  kBudgetExhausted, // Executed max_instrs instructions without halting
+  kFault,           // The guest did something invalid; see Machine::FaultMessage()
+};
+
+struct RunResult {
+  RunStatus status;
+  uint64_t instr_count;
+};
+
+// A single guest. Memory is mapped at 0x8000'0000 and the image is placed there.
+class RISCVEMU_API Machine {
+ public:
+  // Throws EmulatorError if the image does not fit in memory.
+  static std::unique_ptr<Machine> Create(std::span<const uint8_t> image);
+  ~Machine();
+  Machine(const Machine&) = delete;
+  Machine& operator=(const Machine&) = delete;
+
+  // Clears memory and registers, then loads a new image. If the image does not
+  // fit, throws EmulatorError and leaves the machine cleared.
+  void Reset(std::span<const uint8_t> image);
+  RunResult Run(uint64_t max_instrs);
+  const std::string& FaultMessage() const;
+
+  // Throw EmulatorError unless index is 0-31; writes to x0 are ignored.
+  uint64_t ReadReg(int index) const;
+  void WriteReg(int index, uint64_t val);
+  uint64_t ReadPC() const;
+  void WritePC(uint64_t pc);
+  // Return false if any byte of [addr, addr + len) is outside guest memory.
+  bool ReadMem(uint64_t addr, void* dst, size_t len);
+  bool WriteMem(uint64_t addr, const void* src, size_t len);
+
+ private:
+  explicit Machine(std::span<const uint8_t> image);
+
+  std::unique_ptr<CPU> cpu_;
+  std::string fault_;
+  bool halted_;
+};
+
+// Keeps released machines around so that the next Acquire() only has to reset
+// them instead of mapping fresh memory. Safe to use from multiple threads.
+class RISCVEMU_API MachinePool {
+ public:
+  explicit MachinePool(size_t initial_size = 0);
+  std::unique_ptr<Machine> Acquire(std::span<const uint8_t> image);
+  void Release(std::unique_ptr<Machine> machine);
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Machine>> free_;
+};
+
+} // namespace riscvemu
@@ -1,9 +1,12 @@
 #include <cstdint>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "test.hpp"
 #include "cpu.hpp"
+#include "riscvemu.hpp"
+#include "error.hpp"
 
 const std::string kTestDir = "../test/";
 
@@ -23,6 +26,88 @@ void Test::Run() {
   TestBin("sra-srl/sra-srl.bin", a2, -4, a3, -2, a4, -8llu >> 2, a5, -8llu >> 1);
   TestBin("op/op.bin", a2, 0x7f00002a);
   TestBin("fib/fib.bin", a0, 55);
+  TestBin("zba/zba.bin", a2, 106, a3, 112, a4, 124, a5, 0x1'0000'0063, a6, 0x7'FFFF'FFF8, a7, 0xF'FFFF'FFF0,
+          s2, 0x2'0000'0062, s3, 0x3'FFFF'FFFC);
+  TestBin("zbb/zbb.bin", a1, 47, a2, 16, a3, 64, a4, 32, a5, 15, a6, 0x0000'0100'0000'0000, a7, 0xFF'0000,
+          s2, 1llu << 63, s3, 0xFFFF'FFFF'8000'0000, s4, -1, s5, 0xFFFF, s6, -1, s7, 1, s8, -2, s9, -1,
+          s0, 1, s1, -1, s10, 0xFFFF'FFFF'FFFF'FF00, s11, 0x8000'0000, t4, 1llu << 63, t5, 0xFFFF'FFFF'8000'0000,
+          t6, 0x2'0000, ra, 32, gp, 0xFFFF'FFFF'FFFF'8000);
+  TestBin("zbs/zbs.bin", a1, 1llu << 63, a2, 32, a3, 0, a4, 4, a5, 1, a6, 1, a7, 1, s2, 0x8000'0000'0000'0005);
+  TestBin("popcount-rv64i/popcount.bin", a1, 13);
+  TestBin("popcount-zbb/popcount.bin", a1, 13);
+  TestLibrary();
 
   std::cout << "All tests passed!" << std::endl;
 }
+
+void Test::TestLibrary() {
+  // Little-endian encodings of tiny programs.
+  const std::vector<uint8_t> kAddi = {0x13, 0x05, 0xa0, 0x02}; // addi a0, zero, 42
+  const std::vector<uint8_t> kLoop = {0x6f, 0x00, 0x00, 0x00}; // jal zero, 0
+  const std::vector<uint8_t> kIllegal = {0xff, 0xff, 0xff, 0xff};
+
+  std::cout << "Testing libriscvemu ..." << std::endl;
+  riscvemu::MachinePool pool{1};
+
+  auto machine = pool.Acquire(kAddi);
+  riscvemu::RunResult result = machine->Run(100);
+  Check(result.status == riscvemu::RunStatus::kHalted && result.instr_count == 1, "addi did not halt after 1 instruction");
+  Check(machine->ReadReg(a0) == 42, "a0 is not 42");
+  result = machine->Run(100);
+  Check(result.status == riscvemu::RunStatus::kHalted && result.instr_count == 0, "a halted machine ran again");
+  bool threw = false;
+  try {
+    machine->ReadReg(32);
+  } catch (const EmulatorError&) {
+    threw = true;
+  }
+  Check(threw, "ReadReg(32) did not throw EmulatorError");
+  uint64_t val = 0x1234'5678'9abc'def0;
+  Check(machine->WriteMem(kDramBaseAddr + 0x100, &val, sizeof(val)), "WriteMem failed");
+  val = 0;
+  Check(machine->ReadMem(kDramBaseAddr + 0x100, &val, sizeof(val)) && val == 0x1234'5678'9abc'def0, "ReadMem mismatch");
+  Check(!machine->ReadMem(kDramBaseAddr + kDramSize - 4, &val, sizeof(val)), "ReadMem past the end succeeded");
+  pool.Release(std::move(machine));
+
+  // A reused machine must not see the previous guest's state.
+  machine = pool.Acquire(kLoop);
+  result = machine->Run(1000);
+  Check(result.status == riscvemu::RunStatus::kBudgetExhausted && result.instr_count == 1000, "loop did not exhaust its budget");
+  Check(machine->ReadReg(a0) == 0, "a0 was not reset");
+  Check(machine->ReadMem(kDramBaseAddr + 0x100, &val, sizeof(val)) && val == 0, "memory was not reset");
+
+  machine->Reset(kIllegal);
+  result = machine->Run(100);
+  Check(result.status == riscvemu::RunStatus::kFault && !machine->FaultMessage().empty(), "illegal instruction did not fault");
+
+  // A failed reset must still leave a clean machine.
+  machine->WriteReg(a0, 1);
+  threw = false;
+  try {
+    machine->Reset(std::vector<uint8_t>(kDramSize + 1));
+  } catch (const EmulatorError&) {
+    threw = true;
+  }
+  Check(threw && machine->ReadReg(a0) == 0 && machine->FaultMessage().empty(), "failed reset left stale state");
+
+  // Faulting addresses are reported in full.
+  const std::vector<uint8_t> kLoadHigh = {0x13, 0x05, 0x10, 0x00,  // addi a0, zero, 1
+                                          0x13, 0x15, 0x05, 0x02,  // slli a0, a0, 32
+                                          0x03, 0x35, 0x05, 0x00}; // ld a0, 0(a0)
+  machine->Reset(kLoadHigh);
+  result = machine->Run(100);
+  Check(result.status == riscvemu::RunStatus::kFault && machine->FaultMessage().find("0x100000000") != std::string::npos,
+        "fault message does not contain the full address");
+  pool.Release(std::move(machine));
+
+  Check(RunCApiTest() == 0, "C API test failed");
+
+  std::cout << "Passed!" << std::endl;
+}
+
+void Test::Check(bool cond, const std::string& msg) {
+  if (!cond) {
+    std::cout << msg << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+}
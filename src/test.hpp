@@ -8,6 +8,8 @@
 
 extern const std::string kTestDir;
 
+extern "C" int RunCApiTest(void); // capi_test.c
+
 class Test {
  public:
   Test();
@@ -15,6 +17,8 @@ class Test {
 
  private:
   template <class... Args> void TestBin(const std::string& file_path, Args... args);
+  void TestLibrary();
+  void Check(bool cond, const std::string& msg);
 };
 
 template <class... Args>
@@ -22,16 +26,18 @@ void Test::TestBin(const std::string& file_path, Args... args) {
   auto cpu = std::make_unique<CPU>(kTestDir + file_path);
 
   std::cout << "Testing " << file_path << " ..." << std::endl;
+  uint64_t instr_count = 0;
   for(;;) {
     uint32_t instr = cpu->Fetch();
     if (instr == 0)
       break;
     uint64_t new_pc = cpu->Execute(instr);
+    ++instr_count;
     cpu->SetPC(new_pc);
     if (new_pc == 0)
       break;
   }
 
   cpu->AssertRegEq(args...);
-  std::cout << "Passed!" << std::endl;
+  std::cout << "Passed! (" << std::dec << instr_count << " instructions)" << std::endl;
 }
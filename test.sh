@@ -4,18 +4,23 @@ readonly TEST_DIR=test
 
 function make_bin() {
     for dir in $TEST_DIR/*; do
+        # A test may list the extensions it needs in a `march` file, e.g. rv64i_zbb.
+        local march=rv64i
+        if [ -f $dir/march ]; then
+            march=$(cat $dir/march)
+        fi
         for f in $dir/*; do
             local file_ext=${f##*.}
             case $file_ext in
                 c)
                     local filename=${f%.*}
-                    clang -S $f -nostdlib --target=riscv64 -march=rv64i -mabi=lp64 -mno-relax -o $filename.s
-                    clang -Wl,-Ttext=0x0 -nostdlib --target=riscv64 -mabi=lp64 -march=rv64i -mno-relax -o $filename $filename.s
+                    clang -S $f -nostdlib --target=riscv64 -march=$march -mabi=lp64 -mno-relax -o $filename.s
+                    clang -Wl,-Ttext=0x0 -nostdlib --target=riscv64 -mabi=lp64 -march=$march -mno-relax -o $filename $filename.s
                     llvm-objcopy -O binary $filename $filename.bin
                     ;;
                 s)
                     local filename=${f%.*}
-                    clang -Wl,-Ttext=0x0 -nostdlib --target=riscv64 -mabi=lp64 -march=rv64i -mno-relax -o $filename $filename.s
+                    clang -Wl,-Ttext=0x0 -nostdlib --target=riscv64 -mabi=lp64 -march=$march -mno-relax -o $filename $filename.s
                     llvm-objcopy -O binary $filename $filename.bin
                     ;;
             esac
@@ -0,0 +1,11 @@
+main:
+    lui a0, 0x12345
+    addi a0, a0, 0x678
+    addi a1, zero, 0
+loop:
+    beq a0, zero, done
+    addi t0, a0, -1
+    and a0, a0, t0
+    addi a1, a1, 1
+    j loop
+done:
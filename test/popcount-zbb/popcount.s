@@ -0,0 +1,4 @@
+main:
+    lui a0, 0x12345
+    addi a0, a0, 0x678
+    cpop a1, a0
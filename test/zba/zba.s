@@ -0,0 +1,12 @@
+main:
+    addi a0, zero, 3
+    addi a1, zero, 100
+    sh1add a2, a0, a1
+    sh2add a3, a0, a1
+    sh3add a4, a0, a1
+    addi t0, zero, -1
+    add.uw a5, t0, a1
+    sh3add.uw a6, t0, zero
+    slli.uw a7, t0, 4
+    sh1add.uw s2, t0, a1
+    sh2add.uw s3, t0, zero
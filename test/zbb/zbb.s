@@ -0,0 +1,31 @@
+main:
+    lui a0, 0x10
+    clz a1, a0
+    ctz a2, a0
+    addi t0, zero, -1
+    cpop a3, t0
+    cpopw a4, t0
+    clzw a5, a0
+    rev8 a6, a0
+    orc.b a7, a0
+    addi t1, zero, 1
+    rori s2, t1, 1
+    addi t2, zero, 31
+    rolw s3, t1, t2
+    addi t3, zero, 0xff
+    sext.b s4, t3
+    zext.h s5, t0
+    min s6, t0, t1
+    minu s7, t0, t1
+    andn s8, t0, t1
+    xnor s9, t1, t1
+    max s0, t0, t1
+    maxu s1, t0, t1
+    orn s10, zero, t3
+    rol s11, t1, t2
+    ror t4, t1, t1
+    roriw t5, t1, 1
+    rorw t6, a0, t2
+    ctzw ra, zero
+    lui tp, 0x8
+    sext.h gp, tp
@@ -0,0 +1,13 @@
+main:
+    addi a0, zero, 0
+    bseti a1, a0, 63
+    addi t0, zero, 5
+    bset a2, a0, t0
+    binvi a3, a2, 5
+    bclri a4, t0, 0
+    bexti a5, t0, 2
+    addi t1, zero, 63
+    bext a6, a1, t1
+    addi t2, zero, 2
+    bclr a7, t0, t2
+    binv s2, t0, t1